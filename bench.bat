@@ -0,0 +1,4 @@
+del .\benchmark.exe; 
+
+g++ -O2 -DDIVIDED_RECTANGLES_NO_DEBUG -o benchmark.exe .\test\benchmark.cpp .\src\DividedRectangles.cpp;
+.\benchmark.exe
\ No newline at end of file
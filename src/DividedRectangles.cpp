@@ -14,13 +14,23 @@
  * - The `DirectRectangle` structure represents a hyper-rectangle in the search space.
  * - The `direct` function implements the main DIRECT algorithm.
  * - The `optimize` function provides a user-friendly interface for optimization.
+ * - `split_interval`, `direct` and `optimize` are templates defined in the header so that
+ *   any callable objective can be inlined; this file holds the non-template helpers.
+ * - Per-dimension `VariableType`s allow mixed-integer problems; integer dimensions are
+ *   sampled at rounded points, repeated integer points are served from a cache, and
+ *   integer dimensions are no longer split once a cell spans a single value.
+ * - Objective failures (NaN or infinite values) mark a rectangle as infeasible. Hidden
+ *   constraints can be expressed the same way. Infeasible rectangles are ranked by the
+ *   worst value among their feasible neighbors, so failed regions are rarely split again.
  * - Several helper functions are included for interval splitting, radius computation,
  *   and convex hull construction.
- * - Debugging information can be written to files when `DEBUG_MODE` is enabled.
+ * - Debugging information can be written to files when `DIVIDED_RECTANGLES_DEBUG` is enabled
+ *   (the default unless this file is built with `DIVIDED_RECTANGLES_NO_DEBUG`).
  * 
  * @dependencies
  * - Standard C++ libraries: `<vector>`, `<cmath>`, `<algorithm>`, `<functional>`, `<numeric>`,
- *   `<iterator>`, `<iostream>`, `<cassert>`, `<fstream>`.
+ *   `<iterator>`, `<iostream>`, `<cassert>`, `<fstream>`, `<map>`, `<limits>`,
+ *   `<stdexcept>`, `<string>`.
  * - Custom header: `"DividedRectangles.h"`.
  * 
  * @functions
@@ -29,20 +39,30 @@
  * - `is_ccw`: Checks if three rectangles form a counter-clockwise turn.
  * - `basis`: Generates a basis vector for a given dimension.
  * - `compute_radius`: Computes the radius of a rectangle based on its division levels.
+ * - `is_splittable`: Checks whether a dimension can still be divided (integer dimensions stop at unit width).
+ * - `integer_levels`: Counts the admissible values of each integer dimension.
+ * - `scale_to_bounds`: Maps a unit-cube point onto the search bounds, rounding integer dimensions.
+ * - `are_neighbors`: Checks whether two rectangles touch or overlap.
+ * - `assign_surrogate_values`: Gives infeasible rectangles values taken from feasible neighbors.
  * - `get_split_intervals`: Identifies candidate rectangles for splitting.
+ * - `best_rectangle`: Returns the feasible rectangle with the lowest value.
+ * - `center_less`: Orders rectangles by center, used to keep a partition view aligned with its values.
+ * - `set_objective`: Loads one objective's values into a view of a shared partition.
  * - `split_interval`: Splits a rectangle into smaller rectangles based on the objective function.
  * - `direct`: Implements the DIRECT optimization algorithm.
  * - `optimize`: Provides a simplified interface for optimization.
+ * - `direct_multi` / `optimize_multi`: Optimize several objectives over one shared partition.
  * - Test functions (`test_func1` to `test_func6`): Example objective functions for testing.
  * 
  * @debugging
  * - Debugging information is written to files in the `./debugdata/` directory when
- *   `DEBUG_MODE` is defined.
+ *   `DIVIDED_RECTANGLES_DEBUG` is defined.
  * - Debug files include `rects.txt`, `candidates.txt`, and `new_rects.txt`.
  * 
  * @usage
  * - Include this file and the corresponding header in your project.
- * - Define an objective function as a `std::function<double(const std::vector<double>&)>`.
+ * - Define an objective function as any callable taking `const std::vector<double>&`
+ *   (or `std::span<const double>` in C++20) and returning a `double`.
  * - Call the `optimize` function with the objective function, bounds, and optional parameters.
  * 
  * @example
@@ -62,13 +82,21 @@
 #include <iostream>
 #include <cassert>
 #include <fstream>
+#include <map>
+#include <limits>
+#include <stdexcept>
+#include <string>
 
 #include "DividedRectangles.h"
 
-#define DEBUG_MODE
-#ifdef DEBUG_MODE
+// Only this file decides whether debug output is written, so callers need no matching flag.
+#ifndef DIVIDED_RECTANGLES_NO_DEBUG
+#define DIVIDED_RECTANGLES_DEBUG
+#endif
+
 void write_debug_info(const std::vector<DirectRectangle> &rects, const std::string &filename, int iter)
 {
+#ifdef DIVIDED_RECTANGLES_DEBUG
     std::ofstream debug_file(filename, std::ios_base::app);
     for (const auto &rect : rects)
     {
@@ -89,8 +117,8 @@ void write_debug_info(const std::vector<DirectRectangle> &rects, const std::stri
         debug_file << "]" << std::endl;
     }
     debug_file.close();
-}
 #endif
+}
 
 // Function to clamp a value between lower and upper bounds
 
@@ -146,198 +174,229 @@ double compute_radius(const std::vector<int> &d)
     return std::sqrt(sum);
 }
 
-std::vector<DirectRectangle> get_split_intervals(std::vector<DirectRectangle> &rects, double r_min)
+// An integer dimension with `levels` admissible values stops splitting once its width drops to one unit.
+bool is_splittable(int d, int levels)
 {
-    std::sort(rects.begin(), rects.end(), [r_min](const DirectRectangle &a, const DirectRectangle &b)
-              { return (std::abs(a.r - b.r) >= r_min) ? (a.r < b.r) : (a.y < b.y); });
+    if (levels <= 0)
+        return true;
+    return std::pow(3.0, -d) * levels > 1.0 + 1e-9;
+}
 
-    std::vector<DirectRectangle> hull;
-    for (const auto &rect : rects)
+// Exhausted integer dimensions carry no uncertainty and do not contribute to the radius.
+double compute_radius(const std::vector<int> &d, const std::vector<int> &levels)
+{
+    double sum = 0.0;
+    for (size_t i = 0; i < d.size(); ++i)
     {
-        if (!hull.empty() && std::abs(rect.r - hull.back().r) < 1e-9)
-        {
+        if (!is_splittable(d[i], levels[i]))
             continue;
-        }
+        double term = 0.5 * std::pow(3.0, -d[i]);
+        sum += term * term;
+    }
+    return std::sqrt(sum);
+}
 
-        if (!hull.empty() && rect.y <= hull.back().y)
+// Number of admissible integer values per dimension, 0 for continuous dimensions.
+// Throws std::invalid_argument if an integer dimension has no admissible value or more than INT_MAX.
+std::vector<int> integer_levels(const std::vector<double> &lower_bound,
+                                const std::vector<double> &upper_bound,
+                                const std::vector<VariableType> &types)
+{
+    std::vector<int> levels(lower_bound.size(), 0);
+    for (size_t i = 0; i < levels.size(); ++i)
+    {
+        if (types[i] == VariableType::Integer)
         {
-            hull.pop_back();
+            double count = std::floor(upper_bound[i]) - std::ceil(lower_bound[i]) + 1;
+            if (!(count >= 1))
+                throw std::invalid_argument("integer dimension " + std::to_string(i) + " has no integer within its bounds");
+            if (count > std::numeric_limits<int>::max())
+                throw std::invalid_argument("integer dimension " + std::to_string(i) + " has too many values");
+            levels[i] = static_cast<int>(count);
         }
+    }
+    return levels;
+}
 
-        while (hull.size() >= 2)
-        {
-            const DirectRectangle &a = hull.end()[-2];
-            const DirectRectangle &b = hull.end()[-1]; // b.y is greater than a.y
+// Index of the integer value whose unit-width cell contains the unit coordinate x.
+static int integer_slot(double x, int levels)
+{
+    int k = static_cast<int>(std::floor(x * levels));
+    return std::min(std::max(k, 0), levels - 1);
+}
 
-            if (is_ccw(a, b, rect))
-            {
-                hull.pop_back();
-            }else
-            {
-                break;
-            }
-        }
+std::vector<double> scale_to_bounds(const std::vector<double> &x,
+                                    const std::vector<double> &lower_bound,
+                                    const std::vector<double> &upper_bound,
+                                    const std::vector<int> &levels)
+{
+    std::vector<double> scaled(x.size());
+    scale_to_bounds(x, lower_bound, upper_bound, levels, scaled);
+    return scaled;
+}
 
-        hull.push_back(rect);
+// Writes into a caller-owned buffer so the objective can be evaluated without allocating.
+void scale_to_bounds(const std::vector<double> &x,
+                     const std::vector<double> &lower_bound,
+                     const std::vector<double> &upper_bound,
+                     const std::vector<int> &levels,
+                     std::vector<double> &scaled)
+{
+    for (size_t i = 0; i < x.size(); ++i)
+    {
+        if (levels[i] > 0)
+            scaled[i] = std::ceil(lower_bound[i]) + integer_slot(x[i], levels[i]);
+        else
+            scaled[i] = x[i] * (upper_bound[i] - lower_bound[i]) + lower_bound[i];
     }
+}
 
-    auto it = std::remove_if(hull.begin(), hull.end(), [r_min](const DirectRectangle &rect)
-                             { return rect.r < r_min; });
-    hull.erase(it, hull.end());
+// Failed evaluations are stored as +inf so they never poison comparisons.
+double sanitize_value(double y)
+{
+    return std::isfinite(y) ? y : std::numeric_limits<double>::infinity();
+}
 
-    return hull;
+// half_width[k] is the half side length 0.5 * 3^-k of a rectangle divided k times.
+static std::vector<double> half_widths(int max_d)
+{
+    std::vector<double> half_width(max_d + 1);
+    for (int k = 0; k <= max_d; ++k)
+        half_width[k] = 0.5 * std::pow(3.0, -k);
+    return half_width;
 }
 
-std::vector<DirectRectangle> split_interval(const DirectRectangle &rect, const std::function<double(const std::vector<double> &)> &g)
+static int max_division(const DirectRectangle &rect)
 {
-    std::vector<double> c = rect.c;
-    int n = c.size();
-    std::vector<int> d = rect.d;
-    int d_min = *std::min_element(d.begin(), d.end());
+    return rect.d.empty() ? 0 : *std::max_element(rect.d.begin(), rect.d.end());
+}
 
-    std::vector<int> dirs;
-    for (int i = 0; i < d.size(); ++i)
+static bool are_neighbors(const DirectRectangle &a, const DirectRectangle &b, const std::vector<double> &half_width)
+{
+    for (size_t i = 0; i < a.c.size(); ++i)
     {
-        if (d[i] == d_min)
-            dirs.push_back(i);
+        double reach = half_width[a.d[i]] + half_width[b.d[i]];
+        if (std::abs(a.c[i] - b.c[i]) > reach + 1e-12)
+            return false;
     }
+    return true;
+}
 
-    double delta = std::pow(3.0, -d_min - 1);
-    std::vector<std::pair<std::vector<double>, std::vector<double>>> Cs;
-    std::vector<std::pair<double, double>> Ys;
+bool are_neighbors(const DirectRectangle &a, const DirectRectangle &b)
+{
+    return are_neighbors(a, b, half_widths(std::max(max_division(a), max_division(b))));
+}
 
-    for (int i : dirs)
+// Infeasible rectangles take the largest value among their feasible neighbors, or the
+// largest feasible value overall when they have none, as in hidden-constraint DIRECT.
+void assign_surrogate_values(std::vector<DirectRectangle> &rects)
+{
+    std::vector<size_t> feasible, infeasible;
+    double y_max = -std::numeric_limits<double>::infinity();
+    int max_d = 0;
+    for (size_t i = 0; i < rects.size(); ++i)
     {
-        std::vector<double> e = basis(i, n);
-        std::vector<double> c_plus = c;
-        std::vector<double> c_minus = c;
-        for (int k = 0; k < n; ++k)
+        if (rects[i].feasible)
         {
-            c_plus[k] = clamp(c_plus[k] + delta * e[k], 0.0, 1.0);
-            c_minus[k] = clamp(c_minus[k] - delta * e[k], 0.0, 1.0);
+            feasible.push_back(i);
+            y_max = std::max(y_max, rects[i].y);
         }
-        Ys.emplace_back(g(c_plus), g(c_minus));
-        Cs.emplace_back(std::move(c_plus), std::move(c_minus));
-    }
-
-    std::vector<double> minvals;
-    for (const auto &y : Ys)
-    {
-        minvals.push_back(std::min(y.first, y.second));
+        else
+        {
+            infeasible.push_back(i);
+        }
+        max_d = std::max(max_d, max_division(rects[i]));
     }
+    if (infeasible.empty())
+        return;
+    if (!std::isfinite(y_max))
+        y_max = 0.0;
 
-    std::vector<size_t> indices(dirs.size());
-    std::iota(indices.begin(), indices.end(), 0);
-    std::sort(indices.begin(), indices.end(), [&minvals](size_t a, size_t b)
-              { return minvals[a] < minvals[b]; });
-
-    std::vector<DirectRectangle> new_rects;
-    std::vector<int> current_d = d;
-
-    for (size_t idx : indices)
+    std::vector<double> half_width = half_widths(max_d);
+    for (size_t i : infeasible)
     {
-        int dir = dirs[idx];
-        current_d[dir] += 1;
-        double r = compute_radius(current_d);
-        new_rects.emplace_back(Cs[idx].first, Ys[idx].first, current_d, r);
-        new_rects.emplace_back(Cs[idx].second, Ys[idx].second, current_d, r);
+        double y = -std::numeric_limits<double>::infinity();
+        for (size_t j : feasible)
+        {
+            if (are_neighbors(rects[i], rects[j], half_width))
+                y = std::max(y, rects[j].y);
+        }
+        rects[i].y = std::isfinite(y) ? y : y_max;
     }
-
-    new_rects.emplace_back(c, rect.y, current_d, compute_radius(current_d));
-    return new_rects;
 }
 
-std::vector<DirectRectangle> direct(const std::function<double(const std::vector<double> &)> &f,
-                                    const std::vector<double> &lower_bound,
-                                    const std::vector<double> &upper_bound,
-                                    int max_iterations = 100,
-                                    double min_radius = 1e-5)
+std::vector<DirectRectangle> get_split_intervals(std::vector<DirectRectangle> &rects, double r_min)
 {
-    int n = lower_bound.size();
-    auto g = [&](const std::vector<double> &x)
+    std::sort(rects.begin(), rects.end(), [r_min](const DirectRectangle &a, const DirectRectangle &b)
+              { return (std::abs(a.r - b.r) >= r_min) ? (a.r < b.r) : (a.y < b.y); });
+
+    std::vector<DirectRectangle> hull;
+    for (const auto &rect : rects)
     {
-        std::vector<double> scaled(n);
-        for (int i = 0; i < n; ++i)
+        if (!hull.empty() && std::abs(rect.r - hull.back().r) < 1e-9)
         {
-            scaled[i] = x[i] * (upper_bound[i] - lower_bound[i]) + lower_bound[i];
+            continue;
         }
-        return f(scaled);
-    };
 
-    std::vector<double> center(n, 0.5);
-    std::vector<DirectRectangle> rects;
-    rects.emplace_back(center, g(center), std::vector<int>(n, 0), compute_radius(std::vector<int>(n, 0)));
-
-    for (int k = 0; k < max_iterations; ++k)
-    {
-#ifdef DEBUG_MODE
-        write_debug_info(rects, "./debugdata/rects.txt", k);
-#endif
-        auto candidates = get_split_intervals(rects, min_radius);
-
-#ifdef DEBUG_MODE
-        write_debug_info(candidates, "./debugdata/candidates.txt", k);
-#endif
-        std::vector<DirectRectangle> new_rects;
-        for (const auto &rect : rects)
+        if (!hull.empty() && rect.y <= hull.back().y)
         {
-            bool found = false;
-            for (const auto &c : candidates)
-            {
-                if (are_equal(rect, c))
-                {
-                    found = true;
-                    break;
-                }
-            }
-            if (!found)
-                new_rects.push_back(rect);
+            hull.pop_back();
         }
 
-        for (const auto &c : candidates)
+        while (hull.size() >= 2)
         {
-            auto split = split_interval(c, g);
-            new_rects.insert(new_rects.end(), split.begin(), split.end());
+            const DirectRectangle &a = hull.end()[-2];
+            const DirectRectangle &b = hull.end()[-1]; // b.y is greater than a.y
 
-#ifdef DEBUG_MODE
-        write_debug_info(split, "./debugdata/new_rects.txt", k+1);
-#endif
+            if (is_ccw(a, b, rect))
+            {
+                hull.pop_back();
+            }else
+            {
+                break;
+            }
         }
 
-
-        rects.clear();
-        rects = std::move(new_rects);
-
-
+        hull.push_back(rect);
     }
 
-    return rects;
+    auto it = std::remove_if(hull.begin(), hull.end(), [r_min](const DirectRectangle &rect)
+                             { return rect.r < r_min; });
+    hull.erase(it, hull.end());
+
+    return hull;
 }
 
-std::vector<double> optimize(const std::function<double(const std::vector<double> &)> &f,
-                             const std::vector<double> &lower_bound,
-                             const std::vector<double> &upper_bound,
-                             int max_iterations = 100,
-                             double min_radius = 1e-5)
+const DirectRectangle &best_rectangle(const std::vector<DirectRectangle> &rects)
 {
-    auto rects = direct(f, lower_bound, upper_bound, max_iterations, min_radius);
-    if (rects.empty())
-        return std::vector<double>(lower_bound.size(), 0.5);
-
     auto best = std::min_element(rects.begin(), rects.end(),
                                  [](const DirectRectangle &a, const DirectRectangle &b)
                                  {
+                                     if (a.feasible != b.feasible)
+                                         return a.feasible;
                                      return a.y < b.y;
                                  });
+    return *best;
+}
+
+// Orders rectangles by center so that a view of the partition can be realigned with its values.
+bool center_less(const DirectRectangle &a, const DirectRectangle &b)
+{
+    return a.c < b.c;
+}
 
-    std::vector<double> result;
-    for (size_t i = 0; i < best->c.size(); ++i)
+// Sets y of every rectangle in the view to objective k of the aligned values, then gives
+// infeasible rectangles their surrogate values.
+void set_objective(std::vector<DirectRectangle> &view, const std::vector<const std::vector<double> *> &values, size_t k)
+{
+    for (size_t j = 0; j < view.size(); ++j)
     {
-        result.push_back(best->c[i] * (upper_bound[i] - lower_bound[i]) + lower_bound[i]);
+        view[j].y = sanitize_value((*values[j])[k]);
+        view[j].feasible = std::isfinite(view[j].y);
     }
-
-    return result;
+    assign_surrogate_values(view);
 }
+
 double test_func1(const std::vector<double> &x)
 {
     return std::sin(x[0]) + std::sin(2 * x[0]) + std::sin(4 * x[0]) + std::sin(8 * x[0]);
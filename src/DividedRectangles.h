@@ -8,9 +8,20 @@
 #include <numeric>
 #include <iterator>
 #include <cassert>
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
 
 const double DEFAULT_CCW_TOL = 1e-6;
 
+// Type of a search dimension. Categorical variables can be encoded as Integer indices.
+enum class VariableType
+{
+    Continuous,
+    Integer
+};
+
 double clamp(double a, double l, double u);
 
 struct DirectRectangle
@@ -19,27 +30,411 @@ struct DirectRectangle
     double y;
     std::vector<int> d;
     double r;
+    bool feasible; // false if the objective failed at c; y then holds a surrogate value
 
     DirectRectangle(std::vector<double> c, double y, std::vector<int> d, double r)
-        : c(std::move(c)), y(y), d(std::move(d)), r(r) {}
+        : c(std::move(c)), y(y), d(std::move(d)), r(r), feasible(std::isfinite(y)) {}
+    DirectRectangle(std::vector<double> c, double y, std::vector<int> d, double r, bool feasible)
+        : c(std::move(c)), y(y), d(std::move(d)), r(r), feasible(feasible) {}
 };
 
 bool are_equal(const DirectRectangle &a, const DirectRectangle &b, double tol);
 bool is_ccw(const DirectRectangle &a, const DirectRectangle &b, const DirectRectangle &c, double tol);
 std::vector<double> basis(int i, int n);
 double compute_radius(const std::vector<int> &d);
+double compute_radius(const std::vector<int> &d, const std::vector<int> &levels);
+bool is_splittable(int d, int levels);
+std::vector<int> integer_levels(const std::vector<double> &lower_bound,
+                                const std::vector<double> &upper_bound,
+                                const std::vector<VariableType> &types);
+std::vector<double> scale_to_bounds(const std::vector<double> &x,
+                                    const std::vector<double> &lower_bound,
+                                    const std::vector<double> &upper_bound,
+                                    const std::vector<int> &levels);
+void scale_to_bounds(const std::vector<double> &x,
+                     const std::vector<double> &lower_bound,
+                     const std::vector<double> &upper_bound,
+                     const std::vector<int> &levels,
+                     std::vector<double> &scaled);
+double sanitize_value(double y);
+bool are_neighbors(const DirectRectangle &a, const DirectRectangle &b);
+void assign_surrogate_values(std::vector<DirectRectangle> &rects);
 std::vector<DirectRectangle> get_split_intervals(std::vector<DirectRectangle> &rects, double r_min);
-std::vector<DirectRectangle> split_interval(const DirectRectangle &rect, const std::function<double(const std::vector<double> &)> &g);
-std::vector<DirectRectangle> direct(const std::function<double(const std::vector<double> &)> &f,
+const DirectRectangle &best_rectangle(const std::vector<DirectRectangle> &rects);
+bool center_less(const DirectRectangle &a, const DirectRectangle &b);
+void set_objective(std::vector<DirectRectangle> &view, const std::vector<const std::vector<double> *> &values, size_t k);
+
+// Appends rectangles to a file under ./debugdata/; a no-op unless the library was built with
+// debug output (see DIVIDED_RECTANGLES_DEBUG in DividedRectangles.cpp).
+void write_debug_info(const std::vector<DirectRectangle> &rects, const std::string &filename, int iter);
+
+// The splitting and search routines are templates over the objective so that any callable
+// (function pointer, lambda, functor, std::function) can be passed and inlined. The objective
+// is called with a const std::vector<double>& scratch buffer that is reused between calls, so
+// callables taking std::span<const double> (C++20) work as well. Do not keep a reference to it.
+template <typename G>
+std::vector<DirectRectangle> split_interval(const DirectRectangle &rect, G &&g, const std::vector<int> &levels)
+{
+    const std::vector<double> &c = rect.c;
+    int n = c.size();
+    const std::vector<int> &d = rect.d;
+
+    std::vector<int> dirs;
+    int d_min = 0;
+    for (int i = 0; i < n; ++i)
+    {
+        if (!is_splittable(d[i], levels[i]))
+            continue;
+        if (dirs.empty() || d[i] < d_min)
+        {
+            d_min = d[i];
+            dirs.clear();
+        }
+        if (d[i] == d_min)
+            dirs.push_back(i);
+    }
+
+    if (dirs.empty())
+        return {rect};
+
+    double delta = std::pow(3.0, -d_min - 1);
+    std::vector<std::pair<std::vector<double>, std::vector<double>>> Cs;
+    std::vector<std::pair<double, double>> Ys;
+    Cs.reserve(dirs.size());
+    Ys.reserve(dirs.size());
+
+    for (int i : dirs)
+    {
+        std::vector<double> c_plus = c;
+        std::vector<double> c_minus = c;
+        c_plus[i] = clamp(c[i] + delta, 0.0, 1.0);
+        c_minus[i] = clamp(c[i] - delta, 0.0, 1.0);
+        Ys.emplace_back(sanitize_value(g(c_plus)), sanitize_value(g(c_minus)));
+        Cs.emplace_back(std::move(c_plus), std::move(c_minus));
+    }
+
+    std::vector<double> minvals;
+    minvals.reserve(Ys.size());
+    for (const auto &y : Ys)
+    {
+        minvals.push_back(std::min(y.first, y.second));
+    }
+
+    std::vector<size_t> indices(dirs.size());
+    std::iota(indices.begin(), indices.end(), 0);
+    std::sort(indices.begin(), indices.end(), [&minvals](size_t a, size_t b)
+              { return minvals[a] < minvals[b]; });
+
+    std::vector<DirectRectangle> new_rects;
+    new_rects.reserve(2 * dirs.size() + 1);
+    std::vector<int> current_d = d;
+
+    for (size_t idx : indices)
+    {
+        int dir = dirs[idx];
+        current_d[dir] += 1;
+        double r = compute_radius(current_d, levels);
+        new_rects.emplace_back(std::move(Cs[idx].first), Ys[idx].first, current_d, r);
+        new_rects.emplace_back(std::move(Cs[idx].second), Ys[idx].second, current_d, r);
+    }
+
+    new_rects.emplace_back(c, rect.y, current_d, compute_radius(current_d, levels), rect.feasible);
+    return new_rects;
+}
+
+template <typename G>
+std::vector<DirectRectangle> split_interval(const DirectRectangle &rect, G &&g)
+{
+    return split_interval(rect, std::forward<G>(g), std::vector<int>(rect.d.size(), 0));
+}
+
+template <typename F>
+std::vector<DirectRectangle> direct(F &&f,
                                     const std::vector<double> &lower_bound,
                                     const std::vector<double> &upper_bound,
-                                    int max_iterations,
-                                    double min_radius);
-std::vector<double> optimize(const std::function<double(const std::vector<double> &)> &f,
-                              const std::vector<double> &lower_bound,
-                              const std::vector<double> &upper_bound,
-                              int max_iterations,
-                              double min_radius);
+                                    const std::vector<VariableType> &types,
+                                    int max_iterations = 100,
+                                    double min_radius = 1e-5)
+{
+    int n = lower_bound.size();
+    std::vector<int> levels = integer_levels(lower_bound, upper_bound, types);
+    bool has_integers = std::any_of(levels.begin(), levels.end(), [](int l)
+                                    { return l > 0; });
+
+    // Cells narrower than the integer lattice round to points that were already sampled,
+    // so evaluations are cached whenever integer dimensions are present.
+    std::map<std::vector<double>, double> cache;
+    std::vector<double> scaled(n);
+    auto g = [&](const std::vector<double> &x) -> double
+    {
+        scale_to_bounds(x, lower_bound, upper_bound, levels, scaled);
+        const std::vector<double> &point = scaled;
+        if (!has_integers)
+            return f(point);
+        auto it = cache.find(point);
+        if (it != cache.end())
+            return it->second;
+        double y = f(point);
+        cache.emplace(point, y);
+        return y;
+    };
+
+    std::vector<double> center(n, 0.5);
+    std::vector<DirectRectangle> rects;
+    rects.emplace_back(center, sanitize_value(g(center)), std::vector<int>(n, 0), compute_radius(std::vector<int>(n, 0), levels));
+
+    for (int k = 0; k < max_iterations; ++k)
+    {
+        assign_surrogate_values(rects);
+        write_debug_info(rects, "./debugdata/rects.txt", k);
+        auto candidates = get_split_intervals(rects, min_radius);
+
+        write_debug_info(candidates, "./debugdata/candidates.txt", k);
+        std::vector<DirectRectangle> new_rects;
+        new_rects.reserve(rects.size() + candidates.size() * (2 * n + 1));
+        for (auto &rect : rects)
+        {
+            bool found = false;
+            for (const auto &c : candidates)
+            {
+                if (are_equal(rect, c, 1e-9))
+                {
+                    found = true;
+                    break;
+                }
+            }
+            if (!found)
+                new_rects.push_back(std::move(rect));
+        }
+
+        for (const auto &c : candidates)
+        {
+            auto split = split_interval(c, g, levels);
+            new_rects.insert(new_rects.end(), std::make_move_iterator(split.begin()), std::make_move_iterator(split.end()));
+
+            write_debug_info(split, "./debugdata/new_rects.txt", k+1);
+        }
+
+
+        rects.clear();
+        rects = std::move(new_rects);
+
+
+    }
+
+    assign_surrogate_values(rects);
+    return rects;
+}
+
+template <typename F>
+std::vector<DirectRectangle> direct(F &&f,
+                                    const std::vector<double> &lower_bound,
+                                    const std::vector<double> &upper_bound,
+                                    int max_iterations = 100,
+                                    double min_radius = 1e-5)
+{
+    std::vector<VariableType> types(lower_bound.size(), VariableType::Continuous);
+    return direct(std::forward<F>(f), lower_bound, upper_bound, types, max_iterations, min_radius);
+}
+
+template <typename F>
+std::vector<double> optimize(F &&f,
+                             const std::vector<double> &lower_bound,
+                             const std::vector<double> &upper_bound,
+                             const std::vector<VariableType> &types,
+                             int max_iterations = 100,
+                             double min_radius = 1e-5)
+{
+    auto rects = direct(std::forward<F>(f), lower_bound, upper_bound, types, max_iterations, min_radius);
+    if (rects.empty())
+        return std::vector<double>(lower_bound.size(), 0.5);
+
+    return scale_to_bounds(best_rectangle(rects).c, lower_bound, upper_bound, integer_levels(lower_bound, upper_bound, types));
+}
+
+template <typename F>
+std::vector<double> optimize(F &&f,
+                             const std::vector<double> &lower_bound,
+                             const std::vector<double> &upper_bound,
+                             int max_iterations = 100,
+                             double min_radius = 1e-5)
+{
+    std::vector<VariableType> types(lower_bound.size(), VariableType::Continuous);
+    return optimize(std::forward<F>(f), lower_bound, upper_bound, types, max_iterations, min_radius);
+}
+// Multi-objective variant: f returns a std::vector<double> with one value per objective.
+// All objectives share one partition; a rectangle is split when it is potentially optimal
+// for any objective, so each point is evaluated once for all of them. Split directions are
+// ordered by the first objective. Returns one view of the partition per objective.
+// Each iteration splits the union of the objectives' selections, so the saving over K
+// separate runs depends on how much those selections overlap: close to K-fold only for
+// strongly related objectives, and small for unrelated ones.
+// A result whose length differs from the first one is treated as a failed evaluation.
+template <typename F>
+std::vector<std::vector<DirectRectangle>> direct_multi(F &&f,
+                                                       const std::vector<double> &lower_bound,
+                                                       const std::vector<double> &upper_bound,
+                                                       const std::vector<VariableType> &types,
+                                                       int max_iterations = 100,
+                                                       double min_radius = 1e-5)
+{
+    int n = lower_bound.size();
+    std::vector<int> levels = integer_levels(lower_bound, upper_bound, types);
+    bool has_integers = std::any_of(levels.begin(), levels.end(), [](int l)
+                                    { return l > 0; });
+
+    // fresh collects the unit-cube samples and objective vectors of the split in progress.
+    std::vector<std::pair<std::vector<double>, std::vector<double>>> fresh;
+    std::map<std::vector<double>, std::vector<double>> cache;
+    std::vector<double> scaled(n);
+    size_t num_objectives = 0;
+    bool sized = false;
+    auto g = [&](const std::vector<double> &x) -> double
+    {
+        scale_to_bounds(x, lower_bound, upper_bound, levels, scaled);
+        const std::vector<double> &point = scaled;
+        std::vector<double> ys;
+        auto it = has_integers ? cache.find(point) : cache.end();
+        if (it != cache.end())
+        {
+            ys = it->second;
+        }
+        else
+        {
+            ys = f(point);
+            if (!sized)
+            {
+                num_objectives = ys.size();
+                sized = true;
+            }
+            else if (ys.size() != num_objectives)
+            {
+                ys.assign(num_objectives, std::nan(""));
+            }
+            if (has_integers)
+                cache.emplace(point, ys);
+        }
+        double y = ys.empty() ? std::nan("") : ys[0];
+        fresh.emplace_back(x, std::move(ys));
+        return y;
+    };
+
+    std::vector<double> center(n, 0.5);
+    std::vector<DirectRectangle> rects;
+    std::vector<std::vector<double>> rect_values;
+    rects.emplace_back(center, sanitize_value(g(center)), std::vector<int>(n, 0), compute_radius(std::vector<int>(n, 0), levels));
+    rect_values.push_back(std::move(fresh.back().second));
+
+    // One copy of the partition, ordered by center and aligned with view_values, is reused for
+    // every objective; it is put back in center order after each selection reorders it.
+    std::vector<DirectRectangle> view;
+    std::vector<const std::vector<double> *> view_values;
+    auto build_view = [&]()
+    {
+        std::vector<size_t> order(rects.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&rects](size_t a, size_t b)
+                  { return center_less(rects[a], rects[b]); });
+        view.clear();
+        view_values.clear();
+        for (size_t i : order)
+        {
+            view.push_back(rects[i]);
+            view_values.push_back(&rect_values[i]);
+        }
+    };
+
+    for (int k = 0; k < max_iterations; ++k)
+    {
+        write_debug_info(rects, "./debugdata/rects.txt", k);
+        build_view();
+        std::set<std::vector<double>> selected;
+        for (size_t j = 0; j < num_objectives; ++j)
+        {
+            if (j > 0)
+                std::sort(view.begin(), view.end(), center_less);
+            set_objective(view, view_values, j);
+            for (const auto &c : get_split_intervals(view, min_radius))
+                selected.insert(c.c);
+        }
+
+        std::vector<DirectRectangle> new_rects;
+        std::vector<std::vector<double>> new_values;
+        new_rects.reserve(rects.size() + selected.size() * (2 * n + 1));
+        new_values.reserve(new_rects.capacity());
+        for (size_t i = 0; i < rects.size(); ++i)
+        {
+            if (selected.count(rects[i].c) == 0)
+            {
+                new_rects.push_back(std::move(rects[i]));
+                new_values.push_back(std::move(rect_values[i]));
+                continue;
+            }
+            fresh.clear();
+            auto split = split_interval(rects[i], g, levels);
+            for (const auto &child : split)
+            {
+                auto it = std::find_if(fresh.begin(), fresh.end(), [&child](const std::pair<std::vector<double>, std::vector<double>> &sample)
+                                       { return sample.first == child.c; });
+                new_values.push_back(it != fresh.end() ? it->second : rect_values[i]);
+            }
+            new_rects.insert(new_rects.end(), std::make_move_iterator(split.begin()), std::make_move_iterator(split.end()));
+
+            write_debug_info(split, "./debugdata/new_rects.txt", k+1);
+        }
+
+        rects = std::move(new_rects);
+        rect_values = std::move(new_values);
+    }
+
+    build_view();
+    std::vector<std::vector<DirectRectangle>> views(num_objectives, view);
+    for (size_t j = 0; j < num_objectives; ++j)
+        set_objective(views[j], view_values, j);
+    return views;
+}
+
+template <typename F>
+std::vector<std::vector<DirectRectangle>> direct_multi(F &&f,
+                                                       const std::vector<double> &lower_bound,
+                                                       const std::vector<double> &upper_bound,
+                                                       int max_iterations = 100,
+                                                       double min_radius = 1e-5)
+{
+    std::vector<VariableType> types(lower_bound.size(), VariableType::Continuous);
+    return direct_multi(std::forward<F>(f), lower_bound, upper_bound, types, max_iterations, min_radius);
+}
+
+// Returns the best design found for each objective.
+template <typename F>
+std::vector<std::vector<double>> optimize_multi(F &&f,
+                                                const std::vector<double> &lower_bound,
+                                                const std::vector<double> &upper_bound,
+                                                const std::vector<VariableType> &types,
+                                                int max_iterations = 100,
+                                                double min_radius = 1e-5)
+{
+    auto views = direct_multi(std::forward<F>(f), lower_bound, upper_bound, types, max_iterations, min_radius);
+    std::vector<int> levels = integer_levels(lower_bound, upper_bound, types);
+
+    std::vector<std::vector<double>> results;
+    for (const auto &rects : views)
+    {
+        results.push_back(scale_to_bounds(best_rectangle(rects).c, lower_bound, upper_bound, levels));
+    }
+    return results;
+}
+
+template <typename F>
+std::vector<std::vector<double>> optimize_multi(F &&f,
+                                                const std::vector<double> &lower_bound,
+                                                const std::vector<double> &upper_bound,
+                                                int max_iterations = 100,
+                                                double min_radius = 1e-5)
+{
+    std::vector<VariableType> types(lower_bound.size(), VariableType::Continuous);
+    return optimize_multi(std::forward<F>(f), lower_bound, upper_bound, types, max_iterations, min_radius);
+}
 
 double test_func1(const std::vector<double> &x);
 double test_func2(const std::vector<double> &x);
@@ -0,0 +1,200 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+#if __cplusplus >= 202002L
+#include <span>
+#endif
+#include "..\src\DividedRectangles.h"
+
+// Compares the previous std::function based search (kept below as direct_legacy) with the
+// templated optimize. Build the library with -O2 -DDIVIDED_RECTANGLES_NO_DEBUG, otherwise
+// debug file output dominates.
+
+// The pre-template split rule: g is a std::function and every call of it allocates.
+std::vector<DirectRectangle> split_interval_legacy(const DirectRectangle &rect, const std::function<double(const std::vector<double> &)> &g)
+{
+    std::vector<double> c = rect.c;
+    int n = c.size();
+    std::vector<int> d = rect.d;
+    int d_min = *std::min_element(d.begin(), d.end());
+
+    std::vector<int> dirs;
+    for (int i = 0; i < n; ++i)
+    {
+        if (d[i] == d_min)
+            dirs.push_back(i);
+    }
+
+    double delta = std::pow(3.0, -d_min - 1);
+    std::vector<std::pair<std::vector<double>, std::vector<double>>> Cs;
+    std::vector<std::pair<double, double>> Ys;
+
+    for (int i : dirs)
+    {
+        std::vector<double> e = basis(i, n);
+        std::vector<double> c_plus = c;
+        std::vector<double> c_minus = c;
+        for (int k = 0; k < n; ++k)
+        {
+            c_plus[k] = clamp(c_plus[k] + delta * e[k], 0.0, 1.0);
+            c_minus[k] = clamp(c_minus[k] - delta * e[k], 0.0, 1.0);
+        }
+        Ys.emplace_back(g(c_plus), g(c_minus));
+        Cs.emplace_back(std::move(c_plus), std::move(c_minus));
+    }
+
+    std::vector<double> minvals;
+    for (const auto &y : Ys)
+    {
+        minvals.push_back(std::min(y.first, y.second));
+    }
+
+    std::vector<size_t> indices(dirs.size());
+    std::iota(indices.begin(), indices.end(), 0);
+    std::sort(indices.begin(), indices.end(), [&minvals](size_t a, size_t b)
+              { return minvals[a] < minvals[b]; });
+
+    std::vector<DirectRectangle> new_rects;
+    std::vector<int> current_d = d;
+
+    for (size_t idx : indices)
+    {
+        int dir = dirs[idx];
+        current_d[dir] += 1;
+        double r = compute_radius(current_d);
+        new_rects.emplace_back(Cs[idx].first, Ys[idx].first, current_d, r);
+        new_rects.emplace_back(Cs[idx].second, Ys[idx].second, current_d, r);
+    }
+
+    new_rects.emplace_back(c, rect.y, current_d, compute_radius(current_d));
+    return new_rects;
+}
+
+// The pre-template search loop: a scaling lambda that allocates per sample, wrapped in a
+// second std::function, and rectangles copied between iterations.
+std::vector<DirectRectangle> direct_legacy(const std::function<double(const std::vector<double> &)> &f,
+                                           const std::vector<double> &lower_bound,
+                                           const std::vector<double> &upper_bound,
+                                           int max_iterations,
+                                           double min_radius)
+{
+    int n = lower_bound.size();
+    auto g = [&](const std::vector<double> &x)
+    {
+        std::vector<double> scaled(n);
+        for (int i = 0; i < n; ++i)
+        {
+            scaled[i] = x[i] * (upper_bound[i] - lower_bound[i]) + lower_bound[i];
+        }
+        return f(scaled);
+    };
+
+    std::vector<double> center(n, 0.5);
+    std::vector<DirectRectangle> rects;
+    rects.emplace_back(center, g(center), std::vector<int>(n, 0), compute_radius(std::vector<int>(n, 0)));
+
+    for (int k = 0; k < max_iterations; ++k)
+    {
+        auto candidates = get_split_intervals(rects, min_radius);
+        std::vector<DirectRectangle> new_rects;
+        for (const auto &rect : rects)
+        {
+            bool found = false;
+            for (const auto &c : candidates)
+            {
+                if (are_equal(rect, c, 1e-9))
+                {
+                    found = true;
+                    break;
+                }
+            }
+            if (!found)
+                new_rects.push_back(rect);
+        }
+
+        for (const auto &c : candidates)
+        {
+            auto split = split_interval_legacy(c, g);
+            new_rects.insert(new_rects.end(), split.begin(), split.end());
+        }
+
+        rects = std::move(new_rects);
+    }
+
+    return rects;
+}
+
+std::vector<double> optimize_legacy(const std::function<double(const std::vector<double> &)> &f,
+                                    const std::vector<double> &lower_bound,
+                                    const std::vector<double> &upper_bound,
+                                    int max_iterations,
+                                    double min_radius)
+{
+    auto rects = direct_legacy(f, lower_bound, upper_bound, max_iterations, min_radius);
+    return scale_to_bounds(best_rectangle(rects).c, lower_bound, upper_bound, std::vector<int>(lower_bound.size(), 0));
+}
+
+volatile double sink = 0.0;
+
+template <typename Run>
+double time_ms(Run &&run, int repeats)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeats; ++i)
+        sink = sink + run()[0];
+    auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(stop - start).count() / repeats;
+}
+
+void run_benchmark(const std::string &name, double (*f)(const std::vector<double> &),
+                   const std::vector<double> &lower_bound, const std::vector<double> &upper_bound, int repeats)
+{
+    int max_iterations = 100;
+    double min_radius = 1e-5;
+    std::function<double(const std::vector<double> &)> bound = f;
+    auto inlined = [f](const std::vector<double> &x) { return f(x); };
+
+    auto run_legacy = [&] { return optimize_legacy(bound, lower_bound, upper_bound, max_iterations, min_radius); };
+    auto run_function = [&] { return optimize(bound, lower_bound, upper_bound, max_iterations, min_radius); };
+    auto run_lambda = [&] { return optimize(inlined, lower_bound, upper_bound, max_iterations, min_radius); };
+
+    bool same_result = run_legacy() == run_lambda();
+    double t_legacy = time_ms(run_legacy, repeats);
+    double t_function = time_ms(run_function, repeats);
+    double t_lambda = time_ms(run_lambda, repeats);
+
+    std::cout << std::left << std::setw(12) << name << std::right << std::fixed << std::setprecision(3)
+              << std::setw(12) << t_legacy
+              << std::setw(16) << t_function
+              << std::setw(12) << t_lambda
+              << std::setw(10) << std::setprecision(2) << t_legacy / t_lambda << "x"
+              << std::setw(10) << t_function / t_lambda << "x"
+              << std::setw(8) << (same_result ? "yes" : "NO") << std::endl;
+}
+
+int main()
+{
+    int repeats = 20;
+    std::cout << "ms per optimize call, 100 iterations; legacy is the pre-template std::function path" << std::endl;
+    std::cout << std::left << std::setw(12) << "function" << std::right
+              << std::setw(12) << "legacy" << std::setw(16) << "std::function" << std::setw(12) << "lambda"
+              << std::setw(11) << "vs legacy" << std::setw(11) << "binding" << std::setw(8) << "same" << std::endl;
+
+    run_benchmark("test_func1", test_func1, std::vector<double>(1, -2), std::vector<double>(1, 2), repeats);
+    run_benchmark("test_func2", test_func2, std::vector<double>(2, -2), std::vector<double>(2, 2), repeats);
+    run_benchmark("test_func3", test_func3, std::vector<double>(3, -2), std::vector<double>(3, 2), repeats);
+    run_benchmark("test_func4", test_func4, std::vector<double>(4, -2), std::vector<double>(4, 2), repeats);
+    run_benchmark("test_func5", test_func5, std::vector<double>(5, -3), std::vector<double>(5, 3), repeats);
+    run_benchmark("test_func6", test_func6, std::vector<double>(6, -1), std::vector<double>(6, 3), repeats);
+
+#if __cplusplus >= 202002L
+    auto span_func2 = [](std::span<const double> x) { return x[0] * x[0] + x[1] * x[1] + 2; };
+    double t_span = time_ms([&] { return optimize(span_func2, std::vector<double>(2, -2), std::vector<double>(2, 2), 100, 1e-5); }, repeats);
+    std::cout << std::left << std::setw(12) << "span func2" << std::right << std::setw(40) << t_span << std::endl;
+#endif
+
+    return 0;
+}
@@ -2,6 +2,12 @@
 #include <cmath>
 #include <random>
 #include <iomanip>
+#include <set>
+#include <limits>
+#include <stdexcept>
+#if __cplusplus >= 202002L
+#include <span>
+#endif
 #include "..\src\DividedRectangles.h"
 
 void run_test(const std::string& test_name, bool condition) {
@@ -299,6 +305,160 @@ int main() {
     std::cout << std::endl;
     }
 
+    // Test 13: mixed-integer problem, integer dimensions never re-evaluate the same point
+    {
+    std::vector<double> lower_bound13 = {0, -5, -2};
+    std::vector<double> upper_bound13 = {20, 5, 2};
+    std::vector<VariableType> types13 = {VariableType::Integer, VariableType::Integer, VariableType::Continuous};
+    std::multiset<std::vector<double>> seen;
+    auto f = [&seen](const std::vector<double> &x)
+    {
+        seen.insert({x[0], x[1]});
+        return (x[0] - 7) * (x[0] - 7) + (x[1] + 2) * (x[1] + 2) + x[2] * x[2];
+    };
+    result = optimize(f, lower_bound13, upper_bound13, types13, 50, 1e-5);
+    std::cout << "mixed-integer best result: [";
+    for(auto r: result)
+    {
+        std::cout << r << " ";
+    }
+    std::cout <<"]"<< std::endl;
+    run_test("Optimize mixed-integer", result[0] == 7 && result[1] == -2 && std::abs(result[2]) < 1e-2);
+
+    std::vector<double> lower_bound13b = {0, -5};
+    std::vector<double> upper_bound13b = {20, 5};
+    std::vector<VariableType> types13b = {VariableType::Integer, VariableType::Integer};
+    seen.clear();
+    auto g = [&f](const std::vector<double> &x)
+    {
+        return f({x[0], x[1], 0.0});
+    };
+    result = optimize(g, lower_bound13b, upper_bound13b, types13b, 100, 1e-5);
+    std::set<std::vector<double>> unique(seen.begin(), seen.end());
+    std::cout << "integer evaluations: " << seen.size() << ", unique points: " << unique.size() << std::endl;
+    run_test("Optimize integer only", result[0] == 7 && result[1] == -2);
+    run_test("Integer points are evaluated once", seen.size() == unique.size() && unique.size() <= 21 * 11);
+
+    bool rejected = false;
+    try
+    {
+        optimize(g, std::vector<double>{0.2, -5}, std::vector<double>{0.8, 5}, types13b, 10, 1e-5);
+    }
+    catch (const std::invalid_argument &)
+    {
+        rejected = true;
+    }
+    run_test("Integer bounds without an integer are rejected", rejected);
+
+    rejected = false;
+    try
+    {
+        optimize(g, std::vector<double>{0, -1e12}, std::vector<double>{20, 1e12}, types13b, 10, 1e-5);
+    }
+    catch (const std::invalid_argument &)
+    {
+        rejected = true;
+    }
+    run_test("Integer bounds wider than INT_MAX are rejected", rejected);
+    }
+
+    // Test 14: hidden constraint, the objective fails (NaN) when x0 + x1 < 1
+    {
+    std::vector<double> lower_bound14(2, -2);
+    std::vector<double> upper_bound14(2, 2);
+    auto f = [](const std::vector<double> &x)
+    {
+        if (x[0] + x[1] < 1)
+            return std::nan("");
+        return x[0] * x[0] + x[1] * x[1];
+    };
+    result = optimize(f, lower_bound14, upper_bound14, 100, 1e-5);
+    std::cout << "hidden constraint best result: [";
+    for(auto r: result)
+    {
+        std::cout << r << " ";
+    }
+    std::cout <<"]"<< std::endl;
+    run_test("Optimize hidden constraint", result[0] + result[1] >= 1 && std::abs(f(result) - 0.5) < 1e-2);
+
+    // a failed region away from the optimum should hardly be sampled again
+    int evaluations = 0, failures = 0;
+    auto g = [&](const std::vector<double> &x)
+    {
+        ++evaluations;
+        if (x[0] > 1)
+        {
+            ++failures;
+            return std::numeric_limits<double>::infinity();
+        }
+        return x[0] * x[0] + x[1] * x[1];
+    };
+    result = optimize(g, lower_bound14, upper_bound14, 100, 1e-5);
+    std::cout << "evaluations: " << evaluations << ", failures: " << failures << std::endl;
+    run_test("Optimize away from failed region", std::abs(g(result)) < 1e-2);
+    run_test("Failed region is not re-split", failures * 10 < evaluations);
+    }
+
+    // Test 15: any callable can be passed without wrapping it in std::function
+    {
+    std::vector<double> lower_bound15(2, -2);
+    std::vector<double> upper_bound15(2, 2);
+    double offset = 2.0;
+    auto f = [offset](const std::vector<double> &x) { return x[0] * x[0] + x[1] * x[1] + offset; };
+    result = optimize(f, lower_bound15, upper_bound15, 100, 1e-5);
+    run_test("Optimize lambda objective", std::abs(f(result) - 2.0) < 1e-2);
+#if __cplusplus >= 202002L
+    auto g = [](std::span<const double> x) { return x[0] * x[0] + x[1] * x[1] + 2; };
+    result = optimize(g, lower_bound15, upper_bound15, 100, 1e-5);
+    run_test("Optimize span objective", std::abs(g(result) - 2.0) < 1e-2);
+#endif
+    }
+
+    // Test 16: related objectives share one partition and one evaluation per point
+    {
+    std::vector<double> lower_bound16(2, -2);
+    std::vector<double> upper_bound16(2, 2);
+    int shared_calls = 0, single_calls = 0;
+    auto f = [&shared_calls](const std::vector<double> &x)
+    {
+        ++shared_calls;
+        return std::vector<double>{stybtang(x),
+                                   stybtang(x) + 0.1 * x[0] * x[0],
+                                   (x[0] + 1) * (x[0] + 1) + (x[1] - 1) * (x[1] - 1)};
+    };
+    auto results = optimize_multi(f, lower_bound16, upper_bound16, 100, 1e-5);
+    for (size_t k = 0; k < results.size(); ++k)
+    {
+        auto objective = [&single_calls, k](const std::vector<double> &x)
+        {
+            ++single_calls;
+            return std::vector<double>{stybtang(x),
+                                       stybtang(x) + 0.1 * x[0] * x[0],
+                                       (x[0] + 1) * (x[0] + 1) + (x[1] - 1) * (x[1] - 1)}[k];
+        };
+        result = optimize(objective, lower_bound16, upper_bound16, 100, 1e-5);
+        std::cout << "objective " << k << " shared best value: " << f(results[k])[k]
+                  << ", separate best value: " << objective(result) << std::endl;
+    }
+    shared_calls -= 3;
+    single_calls -= 3;
+    std::cout << "shared evaluations: " << shared_calls << ", separate evaluations: " << single_calls << std::endl;
+    run_test("Optimize multi objective 0", std::abs(stybtang(results[0]) + 58.0) < 1e-2);
+    run_test("Optimize multi objective 1", std::abs(stybtang(results[1]) + 0.1 * results[1][0] * results[1][0] + 57.6) < 1e-2);
+    run_test("Optimize multi objective 2", std::abs(results[2][0] + 1) < 1e-2 && std::abs(results[2][1] - 1) < 1e-2);
+    run_test("Shared partition saves evaluations", shared_calls < single_calls);
+
+    // a result of the wrong length counts as a failed evaluation
+    auto h = [](const std::vector<double> &x)
+    {
+        if (x[0] > 1)
+            return std::vector<double>{0.0};
+        return std::vector<double>{x[0] * x[0] + x[1] * x[1], (x[0] - 1) * (x[0] - 1) + x[1] * x[1]};
+    };
+    results = optimize_multi(h, lower_bound16, upper_bound16, 50, 1e-5);
+    run_test("Malformed multi objective results are infeasible", results.size() == 2 && results[0][0] <= 1 && results[1][0] <= 1 && std::abs(results[0][0]) < 1e-2);
+    }
+
     return 0;
 }
 